@@ -6,12 +6,17 @@
 #include <iostream>
 #include <cstdio>
 #include <cstdlib>
+#include <cctype>
 #include <vector>
 #include <set>
+#include <map>
 #include <string>
 #include <unordered_map>
 #include <algorithm>
 #include <utility>
+#include <cstdint>
+#include <climits>
+#include <chrono>
 #include "lexer.h"
 
 using namespace std;
@@ -62,9 +67,19 @@ vector<string> non_terminals;
 set<string> terminalSet;
 set<string> nonTerminalSet;
 
+// Command line options (see main)
+bool reduce_grammar = false;    // -r: drop useless symbols before the task runs
+int lookahead_k = 2;            // -k N: lookahead length for Task 8
+bool transform_grammar = false; // -t: Tasks 9 and 10 use the grammar after Task 6 + Task 5
+bool emit_benchmark = false;    // -b: Task 9 emits the benchmark driver, Task 10 runs timings
+bool streaming_input = false;   // -s: read the grammar with ReadGrammarStreaming
+int max_iterations = 8;         // -i N: iteration budget for Task 11
+
+// Shared by ReadGrammar and the tasks that read input after the grammar
+LexicalAnalyzer lexer;
+
 // read grammar
 void ReadGrammar() {
-    LexicalAnalyzer lexer;
     Token token;
     
     // Process rules until we reach the end of the grammar (HASH)
@@ -133,16 +148,548 @@ void ReadGrammar() {
         }
     }
     
-    // Remove non-terminals from the terminals list
-    auto it = terminals.begin();
-    while (it != terminals.end()) {
-        if (nonTerminalSet.find(*it) != nonTerminalSet.end()) {
-            terminalSet.erase(*it);
-            it = terminals.erase(it);
+    // Remove non-terminals from the terminals list in one pass
+    vector<string> kept_terminals;
+    for (const string& symbol : terminals) {
+        if (nonTerminalSet.find(symbol) != nonTerminalSet.end()) {
+            terminalSet.erase(symbol);
+        } else {
+            kept_terminals.push_back(symbol);
+        }
+    }
+    terminals.swap(kept_terminals);
+}
+
+/*
+ * Tokenizer for streaming ingestion (-s). It reads standard input in
+ * fixed-size chunks and returns the same tokens as LexicalAnalyzer, but
+ * only the current identifier is ever held as a string.
+*/
+class ChunkedTokenizer {
+public:
+    static const size_t CHUNK_SIZE = 64 * 1024;
+
+    TokenType Next(string& lexeme) {
+        int c = Get();
+        while (c != EOF && isspace(c)) {
+            c = Get();
+        }
+        switch (c) {
+            case EOF: return END_OF_FILE;
+            case '*': return STAR;
+            case '|': return OR;
+            case '#': return HASH;
+            case '-':
+                if (Peek() == '>') {
+                    Get();
+                    return ARROW;
+                }
+                return ERROR;
+            default:
+                break;
+        }
+        if (!isalpha(c)) {
+            return ERROR;
+        }
+        lexeme.clear();
+        lexeme.push_back((char) c);
+        while (Peek() != EOF && isalnum(Peek())) {
+            lexeme.push_back((char) Get());
+        }
+        return ID;
+    }
+
+private:
+    int Peek() {
+        if (pos == length) {
+            length = fread(buffer, 1, CHUNK_SIZE, stdin);
+            pos = 0;
+        }
+        return pos < length ? (unsigned char) buffer[pos] : EOF;
+    }
+
+    int Get() {
+        int c = Peek();
+        if (c != EOF) pos++;
+        return c;
+    }
+
+    char buffer[CHUNK_SIZE];
+    size_t pos = 0;
+    size_t length = 0;
+};
+
+ChunkedTokenizer tokenizer;
+
+/*
+ * Rules as interned symbol IDs. The right-hand sides are one symbol
+ * stream kept in fixed-size chunks, so growing it never copies what was
+ * already read.
+*/
+struct CompactGrammar {
+    static const size_t CHUNK_SYMBOLS = 16 * 1024;
+
+    vector<string> names;               // symbol ID -> name, in order of appearance
+    unordered_map<string, int> ids;     // only needed while reading
+    vector<bool> isLhs;                 // symbol ID -> is a non-terminal
+    vector<int> lhsOrder;               // non-terminals in order of first LHS appearance
+    vector<int> ruleLhs;
+    vector<size_t> ruleEnd;             // end of each rule's RHS in the symbol stream
+    vector<vector<int>> chunks;
+    size_t size = 0;
+
+    int Intern(const string& name) {
+        auto it = ids.find(name);
+        if (it != ids.end()) return it->second;
+        int id = (int) names.size();
+        names.push_back(name);
+        ids[name] = id;
+        return id;
+    }
+
+    void Push(int symbol) {
+        if (size % CHUNK_SYMBOLS == 0) {
+            chunks.emplace_back();
+            chunks.back().reserve(CHUNK_SYMBOLS);
+        }
+        chunks.back().push_back(symbol);
+        size++;
+    }
+
+    void EndRule(int lhs) {
+        ruleLhs.push_back(lhs);
+        ruleEnd.push_back(size);
+    }
+
+    size_t RuleBegin(size_t rule) const {
+        return rule == 0 ? 0 : ruleEnd[rule - 1];
+    }
+
+    int At(size_t i) const {
+        return chunks[i / CHUNK_SYMBOLS][i % CHUNK_SYMBOLS];
+    }
+};
+
+CompactGrammar compact_grammar;
+
+/*
+ * Streaming version of ReadGrammar. Symbols are interned as they are
+ * read and rules go straight into compact_grammar. Which symbols are
+ * terminals is decided once at the end from a bitmap of LHS symbols.
+ * Tasks 1-4 read compact_grammar directly; the other tasks call
+ * MaterializeGrammar first.
+*/
+void ReadGrammarStreaming() {
+    CompactGrammar& compact = compact_grammar;
+    string lexeme;
+
+    TokenType token = tokenizer.Next(lexeme);
+    while (token != HASH) {
+        if (token != ID) {
+            cout << "SYNTAX ERROR !!!!!!!!!!!!!!!" << endl;
+            exit(1);
+        }
+        int lhs = compact.Intern(lexeme);
+        if ((size_t) lhs >= compact.isLhs.size()) {
+            compact.isLhs.resize(compact.names.size(), false);
+        }
+        if (!compact.isLhs[lhs]) {
+            compact.isLhs[lhs] = true;
+            compact.lhsOrder.push_back(lhs);
+        }
+
+        if (tokenizer.Next(lexeme) != ARROW) {
+            cout << "SYNTAX ERROR !!!!!!!!!!!!!!!" << endl;
+            exit(1);
+        }
+
+        // Alternatives up to the closing STAR
+        while (true) {
+            token = tokenizer.Next(lexeme);
+            while (token == ID) {
+                compact.Push(compact.Intern(lexeme));
+                token = tokenizer.Next(lexeme);
+            }
+            compact.EndRule(lhs);
+
+            if (token == STAR) {
+                break;
+            } else if (token != OR) {
+                cout << "SYNTAX ERROR !!!!!!!!!!!!!!!" << endl;
+                exit(1);
+            }
+        }
+        token = tokenizer.Next(lexeme);
+    }
+    compact.isLhs.resize(compact.names.size(), false);
+
+    // The intern table is not needed once the grammar is read
+    unordered_map<string, int>().swap(compact.ids);
+}
+
+/*
+ * Fill the global grammar, symbol lists and sets from compact_grammar,
+ * exactly as ReadGrammar fills them. Chunks are released as soon as
+ * their rules are built.
+*/
+void MaterializeGrammar() {
+    CompactGrammar& compact = compact_grammar;
+
+    // Symbols that never appear on a LHS are the terminals
+    for (int nt : compact.lhsOrder) {
+        non_terminals.push_back(compact.names[nt]);
+        nonTerminalSet.insert(compact.names[nt]);
+    }
+    for (size_t id = 0; id < compact.names.size(); id++) {
+        if (!compact.isLhs[id]) {
+            terminals.push_back(compact.names[id]);
+            terminalSet.insert(compact.names[id]);
+        }
+    }
+
+    grammar.reserve(compact.ruleLhs.size());
+    for (size_t r = 0; r < compact.ruleLhs.size(); r++) {
+        size_t begin = compact.RuleBegin(r);
+        Rule rule;
+        rule.lhs = compact.names[compact.ruleLhs[r]];
+        rule.rhs.reserve(compact.ruleEnd[r] - begin);
+        for (size_t i = begin; i < compact.ruleEnd[r]; i++) {
+            rule.rhs.push_back(compact.names[compact.At(i)]);
+        }
+        grammar.push_back(rule);
+
+        for (size_t chunk = begin / CompactGrammar::CHUNK_SYMBOLS;
+             chunk < compact.ruleEnd[r] / CompactGrammar::CHUNK_SYMBOLS; chunk++) {
+            vector<int>().swap(compact.chunks[chunk]);
+        }
+    }
+}
+
+/*
+ * Tasks 1-4 over compact_grammar, for -s. They print the same output as
+ * Task1-Task4 but keep symbols as IDs: nullable is a bitmap and FIRST and
+ * FOLLOW are bitsets over terminal positions.
+*/
+
+// Position of each symbol among the terminals or the non-terminals, -1 otherwise
+void CompactSymbolPositions(vector<int>& terminal_pos, vector<int>& nt_pos, int& num_terminals) {
+    const CompactGrammar& compact = compact_grammar;
+    terminal_pos.assign(compact.names.size(), -1);
+    nt_pos.assign(compact.names.size(), -1);
+    num_terminals = 0;
+    for (size_t id = 0; id < compact.names.size(); id++) {
+        if (!compact.isLhs[id]) {
+            terminal_pos[id] = num_terminals++;
+        }
+    }
+    for (size_t i = 0; i < compact.lhsOrder.size(); i++) {
+        nt_pos[compact.lhsOrder[i]] = (int) i;
+    }
+}
+
+vector<bool> CompactNullable() {
+    const CompactGrammar& compact = compact_grammar;
+    vector<bool> nullable(compact.names.size(), false);
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (size_t r = 0; r < compact.ruleLhs.size(); r++) {
+            if (nullable[compact.ruleLhs[r]]) continue;
+            bool all_nullable = true;
+            for (size_t i = compact.RuleBegin(r); i < compact.ruleEnd[r] && all_nullable; i++) {
+                all_nullable = nullable[compact.At(i)];
+            }
+            if (all_nullable) {
+                nullable[compact.ruleLhs[r]] = true;
+                changed = true;
+            }
+        }
+    }
+    return nullable;
+}
+
+// OR bitset src into dst, returns true if dst changed
+bool UnionBits(uint64_t* dst, const uint64_t* src, size_t words) {
+    bool changed = false;
+    for (size_t w = 0; w < words; w++) {
+        uint64_t merged = dst[w] | src[w];
+        if (merged != dst[w]) {
+            dst[w] = merged;
+            changed = true;
+        }
+    }
+    return changed;
+}
+
+bool SetBit(uint64_t* bits, int position) {
+    uint64_t mask = (uint64_t) 1 << (position % 64);
+    if (bits[position / 64] & mask) return false;
+    bits[position / 64] |= mask;
+    return true;
+}
+
+bool TestBit(const uint64_t* bits, int position) {
+    return (bits[position / 64] >> (position % 64)) & 1;
+}
+
+void CompactTask1() {
+    const CompactGrammar& compact = compact_grammar;
+    for (size_t id = 0; id < compact.names.size(); id++) {
+        if (!compact.isLhs[id]) cout << compact.names[id] << " ";
+    }
+    cout << endl;
+    for (size_t id = 0; id < compact.names.size(); id++) {
+        if (compact.isLhs[id]) cout << compact.names[id] << " ";
+    }
+    cout << endl;
+}
+
+void CompactTask2() {
+    const CompactGrammar& compact = compact_grammar;
+    vector<bool> nullable = CompactNullable();
+
+    cout << "Nullable = { ";
+    bool first = true;
+    for (int nt : compact.lhsOrder) {
+        if (nullable[nt]) {
+            if (!first) cout << ", ";
+            cout << compact.names[nt];
+            first = false;
+        }
+    }
+    cout << " }" << endl;
+}
+
+void CompactTask3() {
+    const CompactGrammar& compact = compact_grammar;
+    vector<int> terminal_pos, nt_pos;
+    int num_terminals;
+    CompactSymbolPositions(terminal_pos, nt_pos, num_terminals);
+    vector<bool> nullable = CompactNullable();
+
+    const size_t words = num_terminals / 64 + 1;
+    vector<uint64_t> FIRST(compact.lhsOrder.size() * words, 0);
+
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (size_t r = 0; r < compact.ruleLhs.size(); r++) {
+            uint64_t* lhs_first = &FIRST[nt_pos[compact.ruleLhs[r]] * words];
+            for (size_t i = compact.RuleBegin(r); i < compact.ruleEnd[r]; i++) {
+                int symbol = compact.At(i);
+                if (terminal_pos[symbol] >= 0) {
+                    changed = SetBit(lhs_first, terminal_pos[symbol]) || changed;
+                    break;
+                }
+                changed = UnionBits(lhs_first, &FIRST[nt_pos[symbol] * words], words) || changed;
+                if (!nullable[symbol]) break;
+            }
+        }
+    }
+
+    // Same format as Task3, epsilon prints as an empty entry
+    for (int nt : compact.lhsOrder) {
+        const uint64_t* nt_first = &FIRST[nt_pos[nt] * words];
+        cout << "FIRST(" << compact.names[nt] << ") = { ";
+        bool first = true;
+        for (size_t id = 0; id < compact.names.size(); id++) {
+            if (terminal_pos[id] >= 0 && TestBit(nt_first, terminal_pos[id])) {
+                if (!first) cout << ", ";
+                cout << compact.names[id];
+                first = false;
+            }
+        }
+        if (nullable[nt] && !first) {
+            cout << ", ";
+        }
+        cout << " }" << endl;
+    }
+}
+
+void CompactTask4() {
+    const CompactGrammar& compact = compact_grammar;
+    if (compact.lhsOrder.empty()) return;
+    vector<int> terminal_pos, nt_pos;
+    int num_terminals;
+    CompactSymbolPositions(terminal_pos, nt_pos, num_terminals);
+
+    // Terminal positions, then $
+    const int end_marker = num_terminals;
+    const size_t words = (num_terminals + 1) / 64 + 1;
+    vector<uint64_t> FOLLOW(compact.lhsOrder.size() * words, 0);
+    SetBit(&FOLLOW[0], end_marker);
+
+    // Task4 leaves the FIRST sets of non-terminals empty, so a non-terminal
+    // gets the terminal right after it, or else the FOLLOW of the LHS
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (size_t r = 0; r < compact.ruleLhs.size(); r++) {
+            const uint64_t* lhs_follow = &FOLLOW[nt_pos[compact.ruleLhs[r]] * words];
+            for (size_t i = compact.RuleBegin(r); i < compact.ruleEnd[r]; i++) {
+                int symbol = compact.At(i);
+                if (nt_pos[symbol] < 0) continue;
+
+                uint64_t* symbol_follow = &FOLLOW[nt_pos[symbol] * words];
+                int next = i + 1 < compact.ruleEnd[r] ? compact.At(i + 1) : -1;
+                if (next >= 0 && terminal_pos[next] >= 0) {
+                    changed = SetBit(symbol_follow, terminal_pos[next]) || changed;
+                } else {
+                    changed = UnionBits(symbol_follow, lhs_follow, words) || changed;
+                }
+            }
+        }
+    }
+
+    for (int nt : compact.lhsOrder) {
+        const uint64_t* nt_follow = &FOLLOW[nt_pos[nt] * words];
+        cout << "FOLLOW(" << compact.names[nt] << ") = { ";
+        bool first = true;
+        if (TestBit(nt_follow, end_marker)) {
+            cout << "$";
+            first = false;
+        }
+        for (size_t id = 0; id < compact.names.size(); id++) {
+            if (terminal_pos[id] >= 0 && TestBit(nt_follow, terminal_pos[id])) {
+                if (!first) cout << ", ";
+                cout << compact.names[id];
+                first = false;
+            }
+        }
+        cout << " }" << endl;
+    }
+}
+
+// Build a name -> position index over a symbol list
+unordered_map<string, int> IndexSymbols(const vector<string>& symbols) {
+    unordered_map<string, int> index;
+    index.reserve(symbols.size());
+    for (size_t i = 0; i < symbols.size(); i++) {
+        index[symbols[i]] = (int) i;
+    }
+    return index;
+}
+
+/*
+ * Remove useless symbols from the grammar in place.
+ * First the non-generating non-terminals (those that cannot derive a
+ * terminal string) are dropped together with every rule using them, then
+ * the non-terminals unreachable from the start symbol are dropped.
+ * Both steps are worklist algorithms, linear in the size of the grammar.
+ * The start symbol is always kept in non_terminals so that
+ * non_terminals[0] stays valid even when the language is empty.
+*/
+void RemoveUselessSymbols() {
+    if (non_terminals.empty()) {
+        return;
+    }
+
+    unordered_map<string, int> nt_index = IndexSymbols(non_terminals);
+    size_t num_nt = non_terminals.size();
+
+    // Step 1: generating non-terminals.
+    // remaining[r] counts the non-terminal occurrences in rule r that are
+    // not yet known to be generating; a rule fires when it reaches zero.
+    vector<int> remaining(grammar.size(), 0);
+    vector<vector<int>> occurrences(num_nt);
+    vector<bool> generating(num_nt, false);
+    vector<int> worklist;
+
+    for (size_t r = 0; r < grammar.size(); r++) {
+        for (const string& symbol : grammar[r].rhs) {
+            auto it = nt_index.find(symbol);
+            if (it != nt_index.end()) {
+                occurrences[it->second].push_back((int) r);
+                remaining[r]++;
+            }
+        }
+    }
+    for (size_t r = 0; r < grammar.size(); r++) {
+        int lhs = nt_index[grammar[r].lhs];
+        if (remaining[r] == 0 && !generating[lhs]) {
+            generating[lhs] = true;
+            worklist.push_back(lhs);
+        }
+    }
+    while (!worklist.empty()) {
+        int nt = worklist.back();
+        worklist.pop_back();
+        for (int r : occurrences[nt]) {
+            int lhs = nt_index[grammar[r].lhs];
+            if (--remaining[r] == 0 && !generating[lhs]) {
+                generating[lhs] = true;
+                worklist.push_back(lhs);
+            }
+        }
+    }
+
+    // Keep only rules made entirely of generating symbols
+    vector<Rule> generating_rules;
+    for (size_t r = 0; r < grammar.size(); r++) {
+        if (generating[nt_index[grammar[r].lhs]] && remaining[r] == 0) {
+            generating_rules.push_back(grammar[r]);
+        }
+    }
+
+    // Step 2: reachable non-terminals, searched from the start symbol
+    vector<vector<int>> rulesByLHS(num_nt);
+    for (size_t r = 0; r < generating_rules.size(); r++) {
+        rulesByLHS[nt_index[generating_rules[r].lhs]].push_back((int) r);
+    }
+
+    vector<bool> reachable(num_nt, false);
+    if (generating[0]) {
+        reachable[0] = true;
+        worklist.push_back(0);
+    }
+    while (!worklist.empty()) {
+        int nt = worklist.back();
+        worklist.pop_back();
+        for (int r : rulesByLHS[nt]) {
+            for (const string& symbol : generating_rules[r].rhs) {
+                auto it = nt_index.find(symbol);
+                if (it != nt_index.end() && !reachable[it->second]) {
+                    reachable[it->second] = true;
+                    worklist.push_back(it->second);
+                }
+            }
+        }
+    }
+
+    // Rebuild the grammar and the symbol lists, preserving order
+    vector<Rule> reduced;
+    set<string> used_terminals;
+    for (const Rule& rule : generating_rules) {
+        if (!reachable[nt_index[rule.lhs]]) {
+            continue;
+        }
+        for (const string& symbol : rule.rhs) {
+            if (terminalSet.find(symbol) != terminalSet.end()) {
+                used_terminals.insert(symbol);
+            }
+        }
+        reduced.push_back(rule);
+    }
+    grammar = reduced;
+
+    vector<string> kept_terminals;
+    for (const string& terminal : terminals) {
+        if (used_terminals.find(terminal) != used_terminals.end()) {
+            kept_terminals.push_back(terminal);
+        }
+    }
+    terminals = kept_terminals;
+    terminalSet = used_terminals;
+
+    vector<string> kept_non_terminals;
+    for (size_t i = 0; i < num_nt; i++) {
+        if (i == 0 || reachable[i]) {
+            kept_non_terminals.push_back(non_terminals[i]);
         } else {
-            ++it;
+            nonTerminalSet.erase(non_terminals[i]);
         }
     }
+    non_terminals = kept_non_terminals;
 }
 
 /* 
@@ -462,16 +1009,59 @@ void Task4() {
     }
 }
 
-// Task 5: left factoring
-void Task5() {
-    // Start with the initial grammar
-    vector<Rule> result = grammar;
+// Non-terminals of a rule set (the LHS symbols) in order of appearance
+vector<string> LhsSymbols(const vector<Rule>& rules) {
+    vector<string> lhs_symbols;
+    set<string> seen;
+    for (const Rule& rule : rules) {
+        if (seen.insert(rule.lhs).second) {
+            lhs_symbols.push_back(rule.lhs);
+        }
+    }
+    return lhs_symbols;
+}
+
+// Every symbol used in a rule set
+set<string> UsedSymbols(const vector<Rule>& rules) {
+    set<string> used;
+    for (const Rule& rule : rules) {
+        used.insert(rule.lhs);
+        used.insert(rule.rhs.begin(), rule.rhs.end());
+    }
+    return used;
+}
+
+// Next name base + counter that is not already a symbol of the grammar
+string FreshNonTerminal(const string& base, unordered_map<string, int>& counters, set<string>& used) {
+    string name = base + to_string(counters[base]++);
+    while (!used.insert(name).second) {
+        name = base + to_string(counters[base]++);
+    }
+    return name;
+}
+
+// Print rules in the "A -> x y #" format used by Tasks 5 and 6
+void PrintRules(const vector<Rule>& rules) {
+    for (const Rule& rule : rules) {
+        cout << rule.lhs << " -> ";
+        for (const string& symbol : rule.rhs) {
+            cout << symbol << " ";
+        }
+        cout << "#" << endl;
+    }
+}
+
+// Left factor a rule set (unsorted result)
+vector<Rule> LeftFactor(const vector<Rule>& rules_in) {
+    // Start with the given grammar
+    vector<Rule> result = rules_in;
     
     // Keep track of counter for new non-terminals
     unordered_map<string, int> counters;
-    for (const string& nt : non_terminals) {
+    for (const string& nt : LhsSymbols(rules_in)) {
         counters[nt] = 1;
     }
+    set<string> used = UsedSymbols(rules_in);
     
     // Process until no more left factoring can be done
     bool changed = true;
@@ -537,8 +1127,7 @@ void Task5() {
                 changed = true;
                 
                 // Create a new non-terminal
-                string new_nt = lhs + to_string(counters[lhs]);
-                counters[lhs]++;
+                string new_nt = FreshNonTerminal(lhs, counters, used);
                 
                 // Create the left-factored rule
                 Rule factored_rule;
@@ -580,37 +1169,33 @@ void Task5() {
         }
     }
     
+    return result;
+}
+
+// Task 5: left factoring
+void Task5() {
+    vector<Rule> result = LeftFactor(grammar);
+
     // Sort the resulting grammar lexicographically
     sort(result.begin(), result.end(), compareLexicographically);
-    
-    // Print the result
-    for (const Rule& rule : result) {
-        cout << rule.lhs << " -> ";
-        if (rule.rhs.empty()) {
-            cout << "";
-        } else {
-            for (size_t i = 0; i < rule.rhs.size(); i++) {
-                cout << rule.rhs[i] << " ";
-            }
-        }
-        cout << "#" << endl;
-    }
+    PrintRules(result);
 }
 
-// Task 6: eliminate left recursion
-void Task6() {
-    // Start with the original grammar
-    vector<Rule> result = grammar;
+// Eliminate left recursion from a rule set (unsorted result)
+vector<Rule> EliminateLeftRecursion(const vector<Rule>& rules_in) {
+    // Start with the given grammar
+    vector<Rule> result = rules_in;
     
     // Sort non-terminals lexicographically
-    vector<string> sorted_nt = non_terminals;
+    vector<string> sorted_nt = LhsSymbols(rules_in);
     sort(sorted_nt.begin(), sorted_nt.end());
     
     // Keep track of counter for new non-terminals
     unordered_map<string, int> counters;
-    for (const string& nt : non_terminals) {
+    for (const string& nt : sorted_nt) {
         counters[nt] = 1;
     }
+    set<string> used = UsedSymbols(rules_in);
     
     // For each non-terminal in the sorted order
     for (size_t i = 0; i < sorted_nt.size(); i++) {
@@ -689,8 +1274,7 @@ void Task6() {
         // If there is direct left recursion
         if (!A_i_alpha.empty()) {
             // Create a new non-terminal A_i1
-            string A_i1 = A_i + to_string(counters[A_i]);
-            counters[A_i]++;
+            string A_i1 = FreshNonTerminal(A_i, counters, used);
             
             // Replace the rules
             vector<Rule> temp_result;
@@ -732,21 +1316,1534 @@ void Task6() {
         }
     }
     
+    return result;
+}
+
+// Task 6: eliminate left recursion
+void Task6() {
+    vector<Rule> result = EliminateLeftRecursion(grammar);
+
     // Sort the resulting grammar lexicographically
     sort(result.begin(), result.end(), compareLexicographically);
-    
-    // Print the result
-    for (const Rule& rule : result) {
-        cout << rule.lhs << " -> ";
-        if (rule.rhs.empty()) {
-            cout << "";
-        } else {
+    PrintRules(result);
+}
+
+// Task 7: remove useless symbols and print the reduced grammar
+void Task7() {
+    RemoveUselessSymbols();
+    PrintRules(grammar);
+}
+
+/*
+ * Lookahead sets of k-length terminal strings, stored as tries over
+ * terminal IDs. Trie nodes are hash-consed: two equal sets always get the
+ * same node ID, so sub-tries are shared between sets and set equality is
+ * an integer compare. Union, k-concatenation and truncation are memoized
+ * on node IDs.
+*/
+struct TrieNode {
+    bool accept;                    // the string ending at this node is in the set
+    vector<pair<int, int>> edges;   // (terminal ID, child node), sorted by terminal
+
+    bool operator==(const TrieNode& other) const {
+        return accept == other.accept && edges == other.edges;
+    }
+};
+
+struct TrieNodeHash {
+    size_t operator()(const TrieNode& node) const {
+        size_t h = node.accept ? 1 : 0;
+        for (const auto& edge : node.edges) {
+            h = h * 1000003u ^ (size_t) edge.first;
+            h = h * 1000003u ^ (size_t) edge.second;
+        }
+        return h;
+    }
+};
+
+class LookaheadTries {
+public:
+    static const int EMPTY = 0;     // the empty set
+    static const int EPSILON = 1;   // the set holding only the empty string
+
+    LookaheadTries() {
+        Intern(false, {});
+        Intern(true, {});
+    }
+
+    // { t }
+    int Single(int terminal) {
+        return Intern(false, {{terminal, EPSILON}});
+    }
+
+    int Union(int a, int b) {
+        if (a == b || b == EMPTY) return a;
+        if (a == EMPTY) return b;
+        if (a > b) swap(a, b);
+
+        uint64_t key = ((uint64_t) a << 32) | (uint32_t) b;
+        auto cached = union_cache.find(key);
+        if (cached != union_cache.end()) return cached->second;
+
+        // Copy, as interning below may reallocate nodes
+        TrieNode x = nodes[a];
+        TrieNode y = nodes[b];
+        vector<pair<int, int>> edges;
+        size_t i = 0, j = 0;
+        while (i < x.edges.size() || j < y.edges.size()) {
+            if (j == y.edges.size() || (i < x.edges.size() && x.edges[i].first < y.edges[j].first)) {
+                edges.push_back(x.edges[i++]);
+            } else if (i == x.edges.size() || y.edges[j].first < x.edges[i].first) {
+                edges.push_back(y.edges[j++]);
+            } else {
+                edges.push_back({x.edges[i].first, Union(x.edges[i].second, y.edges[j].second)});
+                i++;
+                j++;
+            }
+        }
+        int result = Intern(x.accept || y.accept, edges);
+        union_cache[key] = result;
+        return result;
+    }
+
+    // Every string of a cut down to its first k terminals
+    int Truncate(int a, int k) {
+        if (a == EMPTY || a == EPSILON) return a;
+        if (k == 0) return EPSILON;
+
+        uint64_t key = ((uint64_t) a << 32) | (uint32_t) k;
+        auto cached = truncate_cache.find(key);
+        if (cached != truncate_cache.end()) return cached->second;
+
+        TrieNode x = nodes[a];
+        for (auto& edge : x.edges) {
+            edge.second = Truncate(edge.second, k - 1);
+        }
+        int result = Intern(x.accept, x.edges);
+        truncate_cache[key] = result;
+        return result;
+    }
+
+    // { first k terminals of xy : x in a, y in b }
+    int Concat(int a, int b, int k) {
+        if (a == EMPTY || b == EMPTY) return EMPTY;
+        if (k == 0) return EPSILON;
+        if (a == EPSILON) return Truncate(b, k);
+        if (b == EPSILON) return Truncate(a, k);
+
+        if (concat_cache.size() <= (size_t) k) concat_cache.resize(k + 1);
+        uint64_t key = ((uint64_t) a << 32) | (uint32_t) b;
+        auto cached = concat_cache[k].find(key);
+        if (cached != concat_cache[k].end()) return cached->second;
+
+        TrieNode x = nodes[a];
+        vector<pair<int, int>> edges;
+        for (const auto& edge : x.edges) {
+            edges.push_back({edge.first, Concat(edge.second, b, k - 1)});
+        }
+        int result = Intern(false, edges);
+        if (x.accept) {
+            result = Union(result, Truncate(b, k));
+        }
+        concat_cache[k][key] = result;
+        return result;
+    }
+
+    // True if the two sets share a string
+    bool Intersects(int a, int b) {
+        if (a == EMPTY || b == EMPTY) return false;
+        const TrieNode& x = nodes[a];
+        const TrieNode& y = nodes[b];
+        if (x.accept && y.accept) return true;
+        size_t i = 0, j = 0;
+        while (i < x.edges.size() && j < y.edges.size()) {
+            if (x.edges[i].first < y.edges[j].first) {
+                i++;
+            } else if (y.edges[j].first < x.edges[i].first) {
+                j++;
+            } else {
+                if (Intersects(x.edges[i].second, y.edges[j].second)) return true;
+                i++;
+                j++;
+            }
+        }
+        return false;
+    }
+
+    // All strings of the set, shorter strings before their extensions
+    void Strings(int a, vector<int>& prefix, vector<vector<int>>& out) const {
+        const TrieNode& x = nodes[a];
+        if (x.accept) out.push_back(prefix);
+        for (const auto& edge : x.edges) {
+            prefix.push_back(edge.first);
+            Strings(edge.second, prefix, out);
+            prefix.pop_back();
+        }
+    }
+
+private:
+    int Intern(bool accept, vector<pair<int, int>> edges) {
+        TrieNode node;
+        node.accept = accept;
+        // Edges into the empty set carry no strings
+        for (const auto& edge : edges) {
+            if (edge.second != EMPTY) node.edges.push_back(edge);
+        }
+        auto it = index.find(node);
+        if (it != index.end()) return it->second;
+        int id = (int) nodes.size();
+        nodes.push_back(node);
+        index[node] = id;
+        return id;
+    }
+
+    vector<TrieNode> nodes;
+    unordered_map<TrieNode, int, TrieNodeHash> index;
+    unordered_map<uint64_t, int> union_cache;
+    unordered_map<uint64_t, int> truncate_cache;
+    vector<unordered_map<uint64_t, int>> concat_cache;
+};
+
+// Out-of-class definitions, the constants are bound to references
+const int LookaheadTries::EMPTY;
+const int LookaheadTries::EPSILON;
+
+// Task 8: FIRST_k and FOLLOW_k sets, and the lookahead each non-terminal needs
+void Task8() {
+    const int k = lookahead_k;
+    LookaheadTries tries;
+
+    // Terminals are numbered in order of appearance, $ comes last
+    unordered_map<string, int> terminal_id = IndexSymbols(terminals);
+    const int end_marker = (int) terminals.size();
+
+    unordered_map<string, int> FIRST;
+    unordered_map<string, int> FOLLOW;
+    for (const string& non_terminal : non_terminals) {
+        FIRST[non_terminal] = LookaheadTries::EMPTY;
+        FOLLOW[non_terminal] = LookaheadTries::EMPTY;
+    }
+
+    // FIRST_k of rhs[from..], using the current FIRST_k of non-terminals
+    auto sequence_first = [&](const vector<string>& rhs, size_t from) {
+        int result = LookaheadTries::EPSILON;
+        for (size_t i = from; i < rhs.size() && result != LookaheadTries::EMPTY; i++) {
+            auto t = terminal_id.find(rhs[i]);
+            int symbol_set = (t != terminal_id.end()) ? tries.Single(t->second) : FIRST[rhs[i]];
+            result = tries.Concat(result, symbol_set, k);
+        }
+        return result;
+    };
+
+    // Compute FIRST_k sets
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (const Rule& rule : grammar) {
+            int updated = tries.Union(FIRST[rule.lhs], sequence_first(rule.rhs, 0));
+            if (updated != FIRST[rule.lhs]) {
+                FIRST[rule.lhs] = updated;
+                changed = true;
+            }
+        }
+    }
+
+    // Compute FOLLOW_k sets, starting from $ after the start symbol
+    FOLLOW[non_terminals[0]] = tries.Single(end_marker);
+    changed = true;
+    while (changed) {
+        changed = false;
+        for (const Rule& rule : grammar) {
             for (size_t i = 0; i < rule.rhs.size(); i++) {
-                cout << rule.rhs[i] << " ";
+                if (nonTerminalSet.find(rule.rhs[i]) == nonTerminalSet.end()) continue;
+
+                int after = tries.Concat(sequence_first(rule.rhs, i + 1), FOLLOW[rule.lhs], k);
+                int updated = tries.Union(FOLLOW[rule.rhs[i]], after);
+                if (updated != FOLLOW[rule.rhs[i]]) {
+                    FOLLOW[rule.rhs[i]] = updated;
+                    changed = true;
+                }
             }
         }
-        cout << "#" << endl;
     }
+
+    auto print_set = [&](const string& name, int set_id) {
+        vector<vector<int>> strings;
+        vector<int> prefix;
+        tries.Strings(set_id, prefix, strings);
+
+        cout << name << " = { ";
+        for (size_t i = 0; i < strings.size(); i++) {
+            if (i > 0) cout << ", ";
+            if (strings[i].empty()) cout << "epsilon";
+            for (size_t j = 0; j < strings[i].size(); j++) {
+                if (j > 0) cout << " ";
+                cout << (strings[i][j] == end_marker ? "$" : terminals[strings[i][j]]);
+            }
+        }
+        cout << " }" << endl;
+    };
+
+    for (const string& non_terminal : non_terminals) {
+        print_set("FIRST_" + to_string(k) + "(" + non_terminal + ")", FIRST[non_terminal]);
+    }
+    for (const string& non_terminal : non_terminals) {
+        print_set("FOLLOW_" + to_string(k) + "(" + non_terminal + ")", FOLLOW[non_terminal]);
+    }
+
+    // Lookahead sets of each alternative
+    unordered_map<string, vector<int>> alternatives;
+    for (const Rule& rule : grammar) {
+        alternatives[rule.lhs].push_back(tries.Concat(sequence_first(rule.rhs, 0), FOLLOW[rule.lhs], k));
+    }
+
+    // Smallest j <= k for which the alternatives are pairwise disjoint
+    vector<string> needs_more;
+    for (const string& non_terminal : non_terminals) {
+        const vector<int>& sets = alternatives[non_terminal];
+        int needed = 0;
+        for (int j = 1; j <= k && needed == 0; j++) {
+            bool disjoint = true;
+            for (size_t a = 0; a < sets.size() && disjoint; a++) {
+                for (size_t b = a + 1; b < sets.size() && disjoint; b++) {
+                    if (tries.Intersects(tries.Truncate(sets[a], j), tries.Truncate(sets[b], j))) {
+                        disjoint = false;
+                    }
+                }
+            }
+            if (disjoint) needed = j;
+        }
+
+        if (needed == 0) {
+            cout << "LOOKAHEAD(" << non_terminal << ") > " << k << endl;
+        } else {
+            cout << "LOOKAHEAD(" << non_terminal << ") = " << needed << endl;
+        }
+        if (needed != 1) {
+            needs_more.push_back(non_terminal);
+        }
+    }
+
+    cout << "Needs more than one token = { ";
+    for (size_t i = 0; i < needs_more.size(); i++) {
+        if (i > 0) cout << ", ";
+        cout << needs_more[i];
+    }
+    cout << " }" << endl;
+}
+
+/*
+ * Nullable, FIRST and FOLLOW sets of an arbitrary rule set, used by the
+ * tasks that work on transformed grammars. Non-terminals are the LHS
+ * symbols of the rules, every other symbol is a terminal. FIRST holds
+ * terminals only; nullability is kept in its own set.
+*/
+struct GrammarAnalysis {
+    set<string> nonTerminals;
+    set<string> nullable;
+    unordered_map<string, set<string>> FIRST;
+    unordered_map<string, set<string>> FOLLOW;
+};
+
+// FIRST of rhs[from..]; sets all_nullable when the whole suffix is nullable
+set<string> SequenceFirst(const GrammarAnalysis& analysis, const vector<string>& rhs,
+                          size_t from, bool& all_nullable) {
+    set<string> result;
+    all_nullable = true;
+    for (size_t i = from; i < rhs.size(); i++) {
+        if (analysis.nonTerminals.find(rhs[i]) == analysis.nonTerminals.end()) {
+            result.insert(rhs[i]);
+            all_nullable = false;
+            break;
+        }
+        auto first = analysis.FIRST.find(rhs[i]);
+        if (first != analysis.FIRST.end()) {
+            result.insert(first->second.begin(), first->second.end());
+        }
+        if (analysis.nullable.find(rhs[i]) == analysis.nullable.end()) {
+            all_nullable = false;
+            break;
+        }
+    }
+    return result;
+}
+
+/*
+ * Nullable and FIRST fixpoint over the rules whose LHS is in only_lhs, or
+ * over all rules when it is null. Entries of other non-terminals are read
+ * but never changed.
+*/
+void FirstFixpoint(GrammarAnalysis& analysis, const vector<Rule>& rules, const set<string>* only_lhs) {
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (const Rule& rule : rules) {
+            if (only_lhs && only_lhs->find(rule.lhs) == only_lhs->end()) continue;
+
+            bool all_nullable;
+            set<string> first = SequenceFirst(analysis, rule.rhs, 0, all_nullable);
+            set<string>& lhs_first = analysis.FIRST[rule.lhs];
+            for (const string& terminal : first) {
+                if (lhs_first.insert(terminal).second) {
+                    changed = true;
+                }
+            }
+            if (all_nullable && analysis.nullable.insert(rule.lhs).second) {
+                changed = true;
+            }
+        }
+    }
+}
+
+/*
+ * FOLLOW fixpoint that only grows the FOLLOW sets of the non-terminals in
+ * only_targets, or of all non-terminals when it is null.
+*/
+void FollowFixpoint(GrammarAnalysis& analysis, const vector<Rule>& rules, const set<string>* only_targets) {
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (const Rule& rule : rules) {
+            for (size_t i = 0; i < rule.rhs.size(); i++) {
+                if (analysis.nonTerminals.find(rule.rhs[i]) == analysis.nonTerminals.end()) continue;
+                if (only_targets && only_targets->find(rule.rhs[i]) == only_targets->end()) continue;
+
+                bool all_nullable;
+                set<string> follow = SequenceFirst(analysis, rule.rhs, i + 1, all_nullable);
+                if (all_nullable) {
+                    const set<string>& lhs_follow = analysis.FOLLOW[rule.lhs];
+                    follow.insert(lhs_follow.begin(), lhs_follow.end());
+                }
+                set<string>& symbol_follow = analysis.FOLLOW[rule.rhs[i]];
+                for (const string& terminal : follow) {
+                    if (symbol_follow.insert(terminal).second) {
+                        changed = true;
+                    }
+                }
+            }
+        }
+    }
+}
+
+GrammarAnalysis AnalyzeGrammar(const vector<Rule>& rules, const string& start) {
+    GrammarAnalysis analysis;
+    for (const Rule& rule : rules) {
+        analysis.nonTerminals.insert(rule.lhs);
+        analysis.FIRST[rule.lhs];
+        analysis.FOLLOW[rule.lhs];
+    }
+
+    // Nullable and FIRST, then FOLLOW with $ after the start symbol
+    FirstFixpoint(analysis, rules, nullptr);
+    analysis.FOLLOW[start].insert("$");
+    FollowFixpoint(analysis, rules, nullptr);
+    return analysis;
+}
+
+// Terminals that select each rule in an LL(1) parser
+vector<set<string>> PredictSets(const vector<Rule>& rules, const GrammarAnalysis& analysis) {
+    vector<set<string>> predict;
+    for (const Rule& rule : rules) {
+        bool all_nullable;
+        set<string> select = SequenceFirst(analysis, rule.rhs, 0, all_nullable);
+        if (all_nullable) {
+            const set<string>& follow = analysis.FOLLOW.at(rule.lhs);
+            select.insert(follow.begin(), follow.end());
+        }
+        predict.push_back(select);
+    }
+    return predict;
+}
+
+/*
+ * LL(1) parse table over symbol IDs. Terminals are 0..numTerminals-1 with
+ * $ as terminal 0, non-terminal n is numTerminals + n, and the start
+ * symbol is non-terminal 0. Conflicting entries keep the first rule and
+ * are counted in conflicts.
+*/
+struct LL1Table {
+    vector<string> terminalNames;
+    vector<string> nonTerminalNames;
+    int numTerminals = 0;
+    vector<int> ruleLhs;            // non-terminal index of each rule
+    vector<int> ruleStart;          // offsets into ruleRhs, one extra at the end
+    vector<int> ruleRhs;            // symbol IDs
+    vector<int> table;              // [non-terminal * numTerminals + terminal] -> rule or -1
+    int conflicts = 0;
+
+    int Predict(int nt, int terminal) const {
+        return table[nt * numTerminals + terminal];
+    }
+};
+
+LL1Table BuildLL1Table(const vector<Rule>& rules, const string& start) {
+    LL1Table ll1;
+    GrammarAnalysis analysis = AnalyzeGrammar(rules, start);
+    vector<set<string>> predict = PredictSets(rules, analysis);
+
+    // Number the symbols: $ first, then terminals and non-terminals in
+    // order of appearance, start symbol first
+    unordered_map<string, int> terminal_id;
+    unordered_map<string, int> nt_id;
+    ll1.terminalNames.push_back("$");
+    terminal_id["$"] = 0;
+    ll1.nonTerminalNames.push_back(start);
+    nt_id[start] = 0;
+    for (const string& nt : LhsSymbols(rules)) {
+        if (nt_id.find(nt) == nt_id.end()) {
+            nt_id[nt] = (int) ll1.nonTerminalNames.size();
+            ll1.nonTerminalNames.push_back(nt);
+        }
+    }
+    for (const Rule& rule : rules) {
+        for (const string& symbol : rule.rhs) {
+            if (nt_id.find(symbol) == nt_id.end() && terminal_id.find(symbol) == terminal_id.end()) {
+                terminal_id[symbol] = (int) ll1.terminalNames.size();
+                ll1.terminalNames.push_back(symbol);
+            }
+        }
+    }
+    ll1.numTerminals = (int) ll1.terminalNames.size();
+
+    ll1.table.assign(ll1.nonTerminalNames.size() * ll1.numTerminals, -1);
+    for (size_t r = 0; r < rules.size(); r++) {
+        int lhs = nt_id[rules[r].lhs];
+        ll1.ruleLhs.push_back(lhs);
+        ll1.ruleStart.push_back((int) ll1.ruleRhs.size());
+        for (const string& symbol : rules[r].rhs) {
+            auto nt = nt_id.find(symbol);
+            ll1.ruleRhs.push_back(nt != nt_id.end() ? ll1.numTerminals + nt->second : terminal_id[symbol]);
+        }
+        for (const string& terminal : predict[r]) {
+            int& entry = ll1.table[lhs * ll1.numTerminals + terminal_id[terminal]];
+            if (entry == -1) {
+                entry = (int) r;
+            } else {
+                ll1.conflicts++;
+            }
+        }
+    }
+    ll1.ruleStart.push_back((int) ll1.ruleRhs.size());
+    return ll1;
+}
+
+/*
+ * A sentence of the grammar with roughly target_length tokens, as terminal
+ * IDs of the table. While the sentence is short, non-terminals take their
+ * other alternatives round-robin so that recursion grows it; after that
+ * every non-terminal takes its shortest derivation.
+ * Returns false if the start symbol derives no terminal string.
+*/
+bool SampleSentence(const LL1Table& ll1, size_t target_length, vector<int>& sentence) {
+    const int num_nt = (int) ll1.nonTerminalNames.size();
+    const int num_rules = (int) ll1.ruleLhs.size();
+    const int infinite = 1 << 30;
+
+    // Height of the shortest derivation tree of each non-terminal
+    vector<int> height(num_nt, infinite);
+    vector<int> best_rule(num_nt, -1);
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (int r = 0; r < num_rules; r++) {
+            int h = 1;
+            for (int i = ll1.ruleStart[r]; i < ll1.ruleStart[r + 1]; i++) {
+                int symbol = ll1.ruleRhs[i];
+                if (symbol >= ll1.numTerminals) {
+                    h = max(h, height[symbol - ll1.numTerminals] == infinite ? infinite : height[symbol - ll1.numTerminals] + 1);
+                }
+            }
+            if (h < height[ll1.ruleLhs[r]]) {
+                height[ll1.ruleLhs[r]] = h;
+                best_rule[ll1.ruleLhs[r]] = r;
+                changed = true;
+            }
+        }
+    }
+    if (num_nt == 0 || height[0] == infinite) {
+        return false;
+    }
+
+    // Alternatives of each non-terminal that derive terminal strings,
+    // other than the shortest one unless it is the only one
+    vector<vector<int>> alternatives(num_nt);
+    for (int r = 0; r < num_rules; r++) {
+        bool generating = r != best_rule[ll1.ruleLhs[r]];
+        for (int i = ll1.ruleStart[r]; i < ll1.ruleStart[r + 1]; i++) {
+            int symbol = ll1.ruleRhs[i];
+            if (symbol >= ll1.numTerminals && height[symbol - ll1.numTerminals] == infinite) {
+                generating = false;
+            }
+        }
+        if (generating) {
+            alternatives[ll1.ruleLhs[r]].push_back(r);
+        }
+    }
+
+    vector<size_t> next_alternative(num_nt, 0);
+    vector<int> stack(1, ll1.numTerminals);
+    size_t steps = 0;
+    sentence.clear();
+    while (!stack.empty()) {
+        int symbol = stack.back();
+        stack.pop_back();
+        if (symbol < ll1.numTerminals) {
+            sentence.push_back(symbol);
+            continue;
+        }
+
+        int nt = symbol - ll1.numTerminals;
+        int rule = best_rule[nt];
+        if (sentence.size() + stack.size() < target_length && ++steps < 100 * target_length
+            && !alternatives[nt].empty()) {
+            rule = alternatives[nt][next_alternative[nt]++ % alternatives[nt].size()];
+        }
+        for (int i = ll1.ruleStart[rule + 1]; i > ll1.ruleStart[rule]; i--) {
+            stack.push_back(ll1.ruleRhs[i - 1]);
+        }
+    }
+    return true;
+}
+
+// Print a comma separated list of ints for generated code
+void PrintIntList(const vector<int>& values) {
+    for (size_t i = 0; i < values.size(); i++) {
+        cout << (i % 16 == 0 ? "\n    " : " ") << values[i] << ",";
+    }
+    cout << endl;
+}
+
+/*
+ * Task 9: emit a self-contained C++ header with a table-driven LL(1)
+ * parser for the grammar (after left recursion removal and left factoring
+ * with -t). Symbol IDs and rules are constexpr data, the parse table is a
+ * constexpr switch, and parsing runs on a fixed-size stack without heap
+ * allocation. With -b the benchmark driver for that header is emitted
+ * instead. The generated code needs C++14.
+*/
+void Task9() {
+    vector<Rule> rules = grammar;
+    if (transform_grammar) {
+        rules = LeftFactor(EliminateLeftRecursion(rules));
+    }
+    LL1Table ll1 = BuildLL1Table(rules, non_terminals[0]);
+
+    if (emit_benchmark) {
+        vector<int> sentence;
+        if (!SampleSentence(ll1, 1000, sentence)) {
+            sentence.clear();
+        }
+
+        cout << "// Generated by project2 (task 9 -b). Benchmark driver for generated_parser.h" << endl;
+        cout << "#include <chrono>" << endl;
+        cout << "#include <cstdio>" << endl;
+        cout << "#include <cstdlib>" << endl;
+        cout << "#include \"generated_parser.h\"" << endl;
+        cout << endl;
+        cout << "// A sentence of the grammar" << endl;
+        cout << "static const int kSample[] = {";
+        sentence.push_back(0);      // keeps the array non-empty, not part of the input
+        PrintIntList(sentence);
+        cout << "};" << endl;
+        cout << "static const std::size_t kSampleSize = " << sentence.size() - 1 << ";" << endl;
+        cout << endl;
+        cout << "int main(int argc, char* argv[]) {" << endl;
+        cout << "    long iterations = argc > 1 ? std::atol(argv[1]) : 100000;" << endl;
+        cout << "    if (!generated_parser::Parse<1 << 16>(kSample, kSampleSize)) {" << endl;
+        cout << "        std::printf(\"sample sentence rejected\\n\");" << endl;
+        cout << "        return 1;" << endl;
+        cout << "    }" << endl;
+        cout << endl;
+        cout << "    // Read through a volatile pointer so the parses are not hoisted out of the loop" << endl;
+        cout << "    const int* volatile input = kSample;" << endl;
+        cout << "    long accepted = 0;" << endl;
+        cout << "    auto start = std::chrono::steady_clock::now();" << endl;
+        cout << "    for (long i = 0; i < iterations; i++) {" << endl;
+        cout << "        accepted += generated_parser::Parse<1 << 16>(input, kSampleSize);" << endl;
+        cout << "    }" << endl;
+        cout << "    auto stop = std::chrono::steady_clock::now();" << endl;
+        cout << endl;
+        cout << "    double ns = std::chrono::duration<double, std::nano>(stop - start).count();" << endl;
+        cout << "    double tokens = (double) iterations * (kSampleSize + 1);" << endl;
+        cout << "    std::printf(\"%ld parses of %zu tokens: %.3f ms, %.2f ns/token\\n\"," << endl;
+        cout << "                iterations, kSampleSize, ns / 1e6, ns / tokens);" << endl;
+        cout << "    return accepted == iterations ? 0 : 1;" << endl;
+        cout << "}" << endl;
+        return;
+    }
+
+    const int num_nt = (int) ll1.nonTerminalNames.size();
+
+    cout << "// Generated by project2 (task 9). LL(1) parser for start symbol "
+         << ll1.nonTerminalNames[0] << "." << endl;
+    cout << "// Requires C++14. Parsing uses a fixed-size stack and never allocates." << endl;
+    cout << "#ifndef GENERATED_PARSER_H" << endl;
+    cout << "#define GENERATED_PARSER_H" << endl;
+    cout << endl;
+    cout << "#include <cstddef>" << endl;
+    cout << endl;
+    cout << "namespace generated_parser {" << endl;
+    cout << endl;
+
+    // The end marker gets a trailing underscore, which no grammar ID has
+    cout << "// Terminal IDs, T_END_ is the end of input" << endl;
+    cout << "enum Terminal : int {" << endl;
+    for (int t = 0; t < ll1.numTerminals; t++) {
+        cout << "    T_" << (t == 0 ? "END_" : ll1.terminalNames[t]) << " = " << t << "," << endl;
+    }
+    cout << "};" << endl;
+    cout << "constexpr int kNumTerminals = " << ll1.numTerminals << ";" << endl;
+    cout << endl;
+
+    cout << "// Non-terminal IDs; on the parse stack non-terminal n is kNumTerminals + n" << endl;
+    cout << "enum NonTerminal : int {" << endl;
+    for (int n = 0; n < num_nt; n++) {
+        cout << "    N_" << ll1.nonTerminalNames[n] << " = " << n << "," << endl;
+    }
+    cout << "};" << endl;
+    cout << "constexpr int kNumNonTerminals = " << num_nt << ";" << endl;
+    cout << endl;
+
+    cout << "constexpr const char* kTerminalNames[kNumTerminals] = {";
+    for (int t = 0; t < ll1.numTerminals; t++) {
+        cout << (t > 0 ? ", " : " ") << "\"" << ll1.terminalNames[t] << "\"";
+    }
+    cout << " };" << endl;
+    cout << "constexpr const char* kNonTerminalNames[kNumNonTerminals] = {";
+    for (int n = 0; n < num_nt; n++) {
+        cout << (n > 0 ? ", " : " ") << "\"" << ll1.nonTerminalNames[n] << "\"";
+    }
+    cout << " };" << endl;
+    cout << endl;
+
+    cout << "// Rules: right-hand side of rule r is kRuleRhs[kRuleStart[r] .. kRuleStart[r + 1])" << endl;
+    cout << "constexpr int kNumRules = " << ll1.ruleLhs.size() << ";" << endl;
+    cout << "constexpr int kRuleLhs[] = {";
+    PrintIntList(ll1.ruleLhs.empty() ? vector<int>(1, 0) : ll1.ruleLhs);
+    cout << "};" << endl;
+    cout << "constexpr int kRuleStart[] = {";
+    PrintIntList(ll1.ruleStart);
+    cout << "};" << endl;
+    cout << "constexpr int kRuleRhs[] = {";
+    vector<int> rhs = ll1.ruleRhs;
+    rhs.push_back(0);       // keeps the array non-empty
+    PrintIntList(rhs);
+    cout << "};" << endl;
+    cout << endl;
+
+    if (ll1.conflicts > 0) {
+        cout << "// WARNING: the grammar is not LL(1), " << ll1.conflicts
+             << " conflicting table entries kept their first rule" << endl;
+    }
+    cout << "constexpr bool kIsLL1 = " << (ll1.conflicts == 0 ? "true" : "false") << ";" << endl;
+    cout << endl;
+
+    cout << "// Rule that expands non-terminal nt on lookahead t, -1 on a syntax error" << endl;
+    cout << "constexpr int Predict(int nt, int t) {" << endl;
+    cout << "    switch (nt) {" << endl;
+    for (int n = 0; n < num_nt; n++) {
+        cout << "    case N_" << ll1.nonTerminalNames[n] << ":" << endl;
+        cout << "        switch (t) {" << endl;
+        for (size_t r = 0; r < ll1.ruleLhs.size(); r++) {
+            if (ll1.ruleLhs[r] != n) continue;
+            bool any = false;
+            for (int t = 0; t < ll1.numTerminals; t++) {
+                if (ll1.Predict(n, t) != (int) r) continue;
+                cout << (any ? " " : "        ") << "case T_" << (t == 0 ? "END_" : ll1.terminalNames[t]) << ":";
+                any = true;
+            }
+            if (any) {
+                cout << endl << "            return " << r << ";" << endl;
+            }
+        }
+        cout << "        default:" << endl;
+        cout << "            return -1;" << endl;
+        cout << "        }" << endl;
+    }
+    cout << "    }" << endl;
+    cout << "    return -1;" << endl;
+    cout << "}" << endl;
+    cout << endl;
+
+    cout << "// Parse tokens[0 .. n) given as terminal IDs, without a trailing T_END_." << endl;
+    cout << "// Returns false on a syntax error or when more than MaxDepth symbols are pending." << endl;
+    cout << "template <std::size_t MaxDepth = 4096>" << endl;
+    cout << "inline bool Parse(const int* tokens, std::size_t n) {" << endl;
+    cout << "    int stack[MaxDepth];" << endl;
+    cout << "    std::size_t top = 0;" << endl;
+    cout << "    std::size_t pos = 0;" << endl;
+    cout << "    stack[top++] = T_END_;" << endl;
+    cout << "    stack[top++] = kNumTerminals + " << "N_" << ll1.nonTerminalNames[0] << ";" << endl;
+    cout << "    while (top > 0) {" << endl;
+    cout << "        int lookahead = pos < n ? tokens[pos] : T_END_;" << endl;
+    cout << "        int symbol = stack[--top];" << endl;
+    cout << "        if (symbol < kNumTerminals) {" << endl;
+    cout << "            if (symbol != lookahead) return false;" << endl;
+    cout << "            if (symbol == T_END_) return true;" << endl;
+    cout << "            pos++;" << endl;
+    cout << "            continue;" << endl;
+    cout << "        }" << endl;
+    cout << "        int rule = Predict(symbol - kNumTerminals, lookahead);" << endl;
+    cout << "        if (rule < 0) return false;" << endl;
+    cout << "        int begin = kRuleStart[rule];" << endl;
+    cout << "        int end = kRuleStart[rule + 1];" << endl;
+    cout << "        if (top + (end - begin) > MaxDepth) return false;" << endl;
+    cout << "        for (int i = end; i > begin; i--) {" << endl;
+    cout << "            stack[top++] = kRuleRhs[i - 1];" << endl;
+    cout << "        }" << endl;
+    cout << "    }" << endl;
+    cout << "    return false;" << endl;
+    cout << "}" << endl;
+    cout << endl;
+    cout << "}  // namespace generated_parser" << endl;
+    cout << endl;
+    cout << "#endif  // GENERATED_PARSER_H" << endl;
+}
+
+// Table-driven LL(1) recognizer; tokens are terminal IDs of the table, -1 for unknown
+bool LL1Recognize(const LL1Table& ll1, const vector<int>& tokens) {
+    vector<int> stack;
+    stack.push_back(0);
+    stack.push_back(ll1.numTerminals);
+    size_t pos = 0;
+    while (!stack.empty()) {
+        int lookahead = pos < tokens.size() ? tokens[pos] : 0;
+        if (lookahead < 0) return false;
+        int symbol = stack.back();
+        stack.pop_back();
+        if (symbol < ll1.numTerminals) {
+            if (symbol != lookahead) return false;
+            if (symbol == 0) return true;
+            pos++;
+            continue;
+        }
+        int rule = ll1.Predict(symbol - ll1.numTerminals, lookahead);
+        if (rule < 0) return false;
+        for (int i = ll1.ruleStart[rule + 1]; i > ll1.ruleStart[rule]; i--) {
+            stack.push_back(ll1.ruleRhs[i - 1]);
+        }
+    }
+    return false;
+}
+
+/*
+ * Earley recognizer that works on any context-free grammar, including
+ * ambiguous and left-recursive ones. It runs directly on the rule set.
+ *  - Nullable symbols are handled as in Aycock and Horspool: predicting a
+ *    nullable non-terminal also moves the dot over it. The nullable set
+ *    comes from the grammar analysis.
+ *  - Right recursion is linear thanks to Leo's transitive items. They are
+ *    memoized per (set, non-terminal) when a set is finished.
+ *  - All Earley sets live in one flat item vector (set j is the range
+ *    setStart[j] .. setStart[j + 1]). Items with the same postdot symbol in a set
+ *    are chained through nextSamePostdot. Each finished set keeps its
+ *    postdot heads and Leo items as a sorted range of a flat vector. The
+ *    set being built is indexed by dotted rule and by symbol in vectors
+ *    that are reset per set. No storage is hashed or freed between parses.
+ * An item that is derived in more than one way is counted as ambiguous.
+ * Ambiguity inside empty derivations, and inside the chains that Leo items
+ * skip over, is not counted.
+*/
+class EarleyParser {
+public:
+    EarleyParser(const vector<Rule>& rules, const string& start, const set<string>& nullable_set) {
+        // Non-terminals are the LHS symbols, with the start symbol first
+        unordered_map<string, int> nt_id;
+        nt_id[start] = 0;
+        for (const string& nt : LhsSymbols(rules)) {
+            if (nt_id.find(nt) == nt_id.end()) {
+                int id = (int) nt_id.size();
+                nt_id[nt] = id;
+            }
+        }
+        for (const Rule& rule : rules) {
+            for (const string& symbol : rule.rhs) {
+                if (nt_id.find(symbol) == nt_id.end() && terminalId.find(symbol) == terminalId.end()) {
+                    int id = (int) terminalId.size();
+                    terminalId[symbol] = id;
+                }
+            }
+        }
+        numTerminals = (int) terminalId.size();
+
+        // Augmented start symbol S' -> S. S' is on no RHS, so it is always
+        // the top of a Leo chain and its item is never skipped.
+        int num_nt = (int) nt_id.size() + 1;
+        startNonTerminal = num_nt - 1;
+
+        nullable.assign(num_nt, false);
+        for (const auto& nt : nt_id) {
+            if (nullable_set.find(nt.first) != nullable_set.end()) {
+                nullable[nt.second] = true;
+            }
+        }
+        nullable[startNonTerminal] = nullable[0];
+
+        // Flat rule storage, and the rules of each non-terminal
+        vector<vector<int>> rules_of(num_nt);
+        for (size_t r = 0; r < rules.size(); r++) {
+            ruleLhs.push_back(nt_id[rules[r].lhs]);
+            ruleStart.push_back((int) ruleRhs.size());
+            for (const string& symbol : rules[r].rhs) {
+                auto nt = nt_id.find(symbol);
+                ruleRhs.push_back(nt != nt_id.end() ? numTerminals + nt->second : terminalId[symbol]);
+            }
+            rules_of[ruleLhs.back()].push_back((int) r);
+        }
+        startRule = (int) rules.size();
+        ruleLhs.push_back(startNonTerminal);
+        ruleStart.push_back((int) ruleRhs.size());
+        ruleRhs.push_back(numTerminals);
+        rules_of[startNonTerminal].push_back(startRule);
+        ruleStart.push_back((int) ruleRhs.size());
+
+        for (int nt = 0; nt < num_nt; nt++) {
+            rulesOfStart.push_back((int) rulesOf.size());
+            rulesOf.insert(rulesOf.end(), rules_of[nt].begin(), rules_of[nt].end());
+        }
+        rulesOfStart.push_back((int) rulesOf.size());
+
+        int num_symbols = numTerminals + num_nt;
+        slotHead.assign(ruleRhs.size() + ruleLhs.size(), -1);
+        currentPostdot.assign(num_symbols, -1);
+        leoCurrent.assign(num_symbols, LEO_UNKNOWN);
+    }
+
+    // Recognize the input; on rejection errorPosition is the offending token
+    bool Parse(const vector<string>& input) {
+        items.clear();
+        setStart.clear();
+        postdotIndex.clear();
+        postdotStart.assign(1, 0);
+        leoIndex.clear();
+        leoStart.assign(1, 0);
+        leoTops.clear();
+        predictedIn.assign(nullable.size(), -1);
+        ambiguousItems = 0;
+        errorPosition = 0;
+
+        vector<Item> scanned;
+        for (current = 0; current <= (int) input.size(); current++) {
+            setStart.push_back(items.size());
+            BeginSet();
+            if (current == 0) {
+                Predict(startNonTerminal);
+            }
+            for (const Item& item : scanned) {
+                Add(item.rule, item.dot, item.origin, false);
+            }
+            if (items.size() == setStart.back()) {
+                errorPosition = current > 0 ? current - 1 : 0;
+                itemCount = items.size();
+                return false;
+            }
+
+            // Process the set; items appended while processing are processed too
+            for (size_t i = setStart.back(); i < items.size(); i++) {
+                Item item = items[i];
+                int symbol = Postdot(item);
+                if (symbol < 0) {
+                    Complete(item);
+                } else if (symbol >= numTerminals) {
+                    Predict(symbol - numTerminals);
+                    if (nullable[symbol - numTerminals]) {
+                        Add(item.rule, item.dot + 1, item.origin, true);
+                    }
+                }
+            }
+
+            // Leo items of this set, now that it is final
+            FinishSet();
+            for (size_t i = setStart.back(); i < items.size(); i++) {
+                int symbol = Postdot(items[i]);
+                if (symbol >= numTerminals && items[i].dot + 1 == RuleLength(items[i].rule)) {
+                    LeoTop(current, symbol);
+                }
+            }
+            FinishLeo();
+
+            // Scan the next token into the next set
+            scanned.clear();
+            if (current < (int) input.size()) {
+                auto terminal = terminalId.find(input[current]);
+                int head = terminal == terminalId.end() ? -1 : PostdotHead(current, terminal->second);
+                for (int p = head; p != -1; p = items[p].nextSamePostdot) {
+                    scanned.push_back(items[p]);
+                    scanned.back().dot++;
+                }
+            }
+        }
+        itemCount = items.size();
+
+        // Accept if S' -> S . spans the whole input
+        for (size_t i = setStart.back(); i < items.size(); i++) {
+            const Item& item = items[i];
+            if (item.origin == 0 && item.rule == startRule && item.dot == 1) {
+                return true;
+            }
+        }
+        errorPosition = input.size();
+        return false;
+    }
+
+    size_t itemCount = 0;
+    size_t ambiguousItems = 0;
+    size_t errorPosition = 0;
+
+private:
+    struct Item {
+        int rule;
+        int dot;
+        int origin;
+        int nextSamePostdot;    // previous item of the set with the same postdot symbol
+        int nextSameSlot;       // previous item of the set with the same dotted rule
+        bool ambiguous;
+    };
+
+    static const int LEO_UNKNOWN = -2;
+
+    int RuleLength(int rule) const {
+        return ruleStart[rule + 1] - ruleStart[rule];
+    }
+
+    // Symbol after the dot, -1 for a complete item
+    int Postdot(const Item& item) const {
+        return item.dot < RuleLength(item.rule) ? ruleRhs[ruleStart[item.rule] + item.dot] : -1;
+    }
+
+    // Look a symbol up in the sorted (symbol, value) range of a finished set
+    static int FindInSet(const vector<pair<int, int>>& index, const vector<size_t>& starts,
+                         int set, int symbol) {
+        auto begin = index.begin() + starts[set];
+        auto end = index.begin() + starts[set + 1];
+        auto found = lower_bound(begin, end, make_pair(symbol, INT_MIN));
+        return found != end && found->first == symbol ? found->second : -1;
+    }
+
+    // First item with symbol after the dot in a finished set, -1 if none
+    int PostdotHead(int set, int symbol) const {
+        return FindInSet(postdotIndex, postdotStart, set, symbol);
+    }
+
+    // Clear the per-set indexes left over from the previous set
+    void BeginSet() {
+        for (int slot : touchedSlots) {
+            slotHead[slot] = -1;
+        }
+        touchedSlots.clear();
+        for (int symbol : touchedSymbols) {
+            currentPostdot[symbol] = -1;
+        }
+        touchedSymbols.clear();
+    }
+
+    // Store the postdot index of the current set, sorted by symbol
+    void FinishSet() {
+        sort(touchedSymbols.begin(), touchedSymbols.end());
+        for (int symbol : touchedSymbols) {
+            postdotIndex.push_back({symbol, currentPostdot[symbol]});
+        }
+        postdotStart.push_back(postdotIndex.size());
+    }
+
+    // Add an item to the current set. derived is true when the item comes
+    // from completing a sub-derivation; deriving an item twice is ambiguity.
+    void Add(int rule, int dot, int origin, bool derived) {
+        int slot = ruleStart[rule] + rule + dot;
+        for (int i = slotHead[slot]; i != -1; i = items[i].nextSameSlot) {
+            if (items[i].origin != origin) continue;
+            if (derived && !items[i].ambiguous) {
+                items[i].ambiguous = true;
+                ambiguousItems++;
+            }
+            return;
+        }
+
+        int index = (int) items.size();
+        if (slotHead[slot] == -1) {
+            touchedSlots.push_back(slot);
+        }
+        items.push_back({rule, dot, origin, -1, slotHead[slot], false});
+        slotHead[slot] = index;
+
+        int symbol = Postdot(items.back());
+        if (symbol >= 0) {
+            if (currentPostdot[symbol] == -1) {
+                touchedSymbols.push_back(symbol);
+            }
+            items.back().nextSamePostdot = currentPostdot[symbol];
+            currentPostdot[symbol] = index;
+        }
+    }
+
+    void Predict(int nt) {
+        if (predictedIn[nt] == current) return;
+        predictedIn[nt] = current;
+        for (int i = rulesOfStart[nt]; i < rulesOfStart[nt + 1]; i++) {
+            Add(rulesOf[i], 0, current, false);
+        }
+    }
+
+    void Complete(const Item& item) {
+        // Empty completions were handled when the non-terminal was predicted
+        if (item.origin == current) return;
+
+        int symbol = numTerminals + ruleLhs[item.rule];
+        int top = LeoTop(item.origin, symbol);
+        if (top >= 0) {
+            Add(leoTops[top].first, RuleLength(leoTops[top].first), leoTops[top].second, true);
+            return;
+        }
+        for (int p = PostdotHead(item.origin, symbol); p != -1; p = items[p].nextSamePostdot) {
+            Item parent = items[p];
+            Add(parent.rule, parent.dot + 1, parent.origin, true);
+        }
+    }
+
+    /*
+     * Topmost item of the deterministic chain above non-terminal symbol in
+     * a set, as an index into leoTops, or -1 if there is none. A chain
+     * exists when the only item with the symbol after its dot has it as
+     * its last symbol. Only the current set is computed, earlier sets are
+     * looked up.
+    */
+    int LeoTop(int set, int symbol) {
+        if (set != current) {
+            return FindInSet(leoIndex, leoStart, set, symbol);
+        }
+        if (leoCurrent[symbol] != LEO_UNKNOWN) return leoCurrent[symbol];
+
+        leoTouched.push_back(symbol);
+        leoCurrent[symbol] = -1;    // guards against unit rule cycles
+        int head = PostdotHead(set, symbol);
+        if (head == -1 || items[head].nextSamePostdot != -1) return -1;
+        Item parent = items[head];
+        if (parent.dot + 1 != RuleLength(parent.rule)) return -1;
+
+        int top = LeoTop(parent.origin, numTerminals + ruleLhs[parent.rule]);
+        if (top < 0) {
+            top = (int) leoTops.size();
+            leoTops.push_back({parent.rule, parent.origin});
+        }
+        leoCurrent[symbol] = top;
+        return top;
+    }
+
+    // Store the Leo items of the current set, sorted by symbol
+    void FinishLeo() {
+        sort(leoTouched.begin(), leoTouched.end());
+        for (int symbol : leoTouched) {
+            if (leoCurrent[symbol] >= 0) {
+                leoIndex.push_back({symbol, leoCurrent[symbol]});
+            }
+            leoCurrent[symbol] = LEO_UNKNOWN;
+        }
+        leoTouched.clear();
+        leoStart.push_back(leoIndex.size());
+    }
+
+    // Grammar; terminals are 0..numTerminals-1, non-terminal n is numTerminals + n
+    int numTerminals = 0;
+    int startNonTerminal = 0;       // the augmented S'
+    int startRule = 0;              // S' -> S
+    unordered_map<string, int> terminalId;
+    vector<int> ruleLhs;
+    vector<int> ruleStart;
+    vector<int> ruleRhs;
+    vector<int> rulesOfStart;
+    vector<int> rulesOf;
+    vector<bool> nullable;
+
+    // Chart: every set's items, postdot index and Leo items are ranges of
+    // flat vectors, so adding an item never allocates a node
+    int current = 0;
+    vector<Item> items;
+    vector<size_t> setStart;
+    vector<pair<int, int>> postdotIndex;    // (symbol, first item) per finished set
+    vector<size_t> postdotStart;
+    vector<pair<int, int>> leoIndex;        // (non-terminal, leoTops index) per finished set
+    vector<size_t> leoStart;
+    vector<pair<int, int>> leoTops;         // (rule, origin) of complete items
+    vector<int> predictedIn;
+
+    // Indexes of the set being built, reset through the touched lists
+    vector<int> slotHead;                   // dotted rule -> last item
+    vector<int> touchedSlots;
+    vector<int> currentPostdot;             // symbol -> last item
+    vector<int> touchedSymbols;
+    vector<int> leoCurrent;                 // symbol -> Leo state while finishing the set
+    vector<int> leoTouched;
+};
+
+const int EarleyParser::LEO_UNKNOWN;
+
+// Read the tokens that follow the grammar, up to the end of input
+vector<string> ReadInputTokens() {
+    vector<string> input;
+    if (streaming_input) {
+        string lexeme;
+        TokenType token = tokenizer.Next(lexeme);
+        while (token == ID) {
+            input.push_back(lexeme);
+            token = tokenizer.Next(lexeme);
+        }
+        if (token != END_OF_FILE) {
+            cout << "SYNTAX ERROR !!!!!!!!!!!!!!!" << endl;
+            exit(1);
+        }
+        return input;
+    }
+
+    Token token = lexer.GetToken();
+    while (token.token_type == ID) {
+        input.push_back(token.lexeme);
+        token = lexer.GetToken();
+    }
+    if (token.token_type != END_OF_FILE) {
+        cout << "SYNTAX ERROR !!!!!!!!!!!!!!!" << endl;
+        exit(1);
+    }
+    return input;
+}
+
+/*
+ * Task 10: parse the input that follows the grammar with the Earley
+ * parser and report whether it is accepted and how ambiguous it is.
+ * With -b, time the Earley parser against the LL(1) table parser, on the
+ * input or on sample sentences of growing length when there is no input.
+ * With -t the LL(1) parser uses the grammar after Tasks 6 and 5.
+*/
+void Task10() {
+    vector<string> input = ReadInputTokens();
+    GrammarAnalysis analysis = AnalyzeGrammar(grammar, non_terminals[0]);
+    EarleyParser earley(grammar, non_terminals[0], analysis.nullable);
+
+    if (!emit_benchmark) {
+        if (earley.Parse(input)) {
+            cout << "Result = ACCEPT" << endl;
+        } else {
+            cout << "Result = REJECT at token " << earley.errorPosition + 1 << endl;
+        }
+        cout << "Chart items = " << earley.itemCount << endl;
+        cout << "Ambiguous items = " << earley.ambiguousItems << endl;
+        return;
+    }
+
+    // The LL(1) side may run on the transformed grammar, same language
+    vector<Rule> ll1_rules = grammar;
+    if (transform_grammar) {
+        ll1_rules = LeftFactor(EliminateLeftRecursion(ll1_rules));
+    }
+    LL1Table ll1 = BuildLL1Table(ll1_rules, non_terminals[0]);
+    vector<vector<string>> samples;
+    if (!input.empty()) {
+        samples.push_back(input);
+    } else {
+        for (size_t length = 1000; length <= 16000; length *= 2) {
+            vector<int> sentence;
+            if (!SampleSentence(ll1, length, sentence)) break;
+            if (!samples.empty() && sentence.size() <= samples.back().size()) break;
+            vector<string> names;
+            for (int terminal : sentence) {
+                names.push_back(ll1.terminalNames[terminal]);
+            }
+            samples.push_back(names);
+        }
+    }
+
+    unordered_map<string, int> ll1_terminal = IndexSymbols(ll1.terminalNames);
+    for (const vector<string>& sample : samples) {
+        vector<int> tokens;
+        for (const string& name : sample) {
+            auto terminal = ll1_terminal.find(name);
+            tokens.push_back(terminal == ll1_terminal.end() || terminal->second == 0 ? -1 : terminal->second);
+        }
+        size_t repeats = max((size_t) 1, (size_t) 200000 / (sample.size() + 1));
+        double token_count = (double) repeats * (sample.size() + 1);
+
+        bool accepted = false;
+        auto start = chrono::steady_clock::now();
+        for (size_t i = 0; i < repeats; i++) {
+            accepted = earley.Parse(sample);
+        }
+        double earley_ns = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count();
+
+        cout << "tokens = " << sample.size() << ": Earley "
+             << (accepted ? "accepts" : "rejects") << ", "
+             << earley_ns / token_count << " ns/token, "
+             << earley.itemCount << " items, " << earley.ambiguousItems << " ambiguous; ";
+
+        if (ll1.conflicts > 0) {
+            cout << "LL(1) n/a (grammar is not LL(1))" << endl;
+            continue;
+        }
+        start = chrono::steady_clock::now();
+        for (size_t i = 0; i < repeats; i++) {
+            accepted = LL1Recognize(ll1, tokens);
+        }
+        double ll1_ns = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count();
+        cout << "LL(1) " << (accepted ? "accepts" : "rejects") << ", "
+             << ll1_ns / token_count << " ns/token" << endl;
+    }
+}
+
+// Non-terminals whose rules differ between two versions of a grammar
+set<string> ChangedNonTerminals(const vector<Rule>& before, const vector<Rule>& after) {
+    map<string, vector<vector<string>>> old_rules;
+    map<string, vector<vector<string>>> new_rules;
+    for (const Rule& rule : before) {
+        old_rules[rule.lhs].push_back(rule.rhs);
+    }
+    for (const Rule& rule : after) {
+        new_rules[rule.lhs].push_back(rule.rhs);
+    }
+
+    set<string> changed;
+    for (auto& entry : old_rules) {
+        sort(entry.second.begin(), entry.second.end());
+    }
+    for (auto& entry : new_rules) {
+        sort(entry.second.begin(), entry.second.end());
+        auto old_entry = old_rules.find(entry.first);
+        if (old_entry == old_rules.end() || old_entry->second != entry.second) {
+            changed.insert(entry.first);
+        }
+    }
+    for (const auto& entry : old_rules) {
+        if (new_rules.find(entry.first) == new_rules.end()) {
+            changed.insert(entry.first);
+        }
+    }
+    return changed;
+}
+
+/*
+ * Bring an analysis of old_rules up to date for new_rules, where only the
+ * non-terminals in touched changed their rules. Nullable and FIRST are
+ * recomputed for touched and everything that uses them, FOLLOW for the
+ * non-terminals whose FOLLOW inputs may have changed; all other entries
+ * are kept. Returns the number of non-terminals recomputed.
+*/
+size_t UpdateAnalysis(GrammarAnalysis& analysis, const vector<Rule>& old_rules,
+                      const vector<Rule>& new_rules, const set<string>& touched, const string& start) {
+    if (touched.empty()) {
+        return 0;
+    }
+
+    analysis.nonTerminals.clear();
+    unordered_map<string, vector<const Rule*>> rulesByLHS;
+    unordered_map<string, vector<string>> users;    // symbol -> LHS of rules using it
+    for (const Rule& rule : new_rules) {
+        analysis.nonTerminals.insert(rule.lhs);
+        rulesByLHS[rule.lhs].push_back(&rule);
+    }
+    // Every RHS symbol counts, a touched non-terminal may have lost its rules
+    for (const Rule& rule : new_rules) {
+        for (const string& symbol : rule.rhs) {
+            users[symbol].push_back(rule.lhs);
+        }
+    }
+
+    // Nullable and FIRST: touched plus everything that depends on them
+    set<string> affected;
+    vector<string> worklist(touched.begin(), touched.end());
+    while (!worklist.empty()) {
+        string nt = worklist.back();
+        worklist.pop_back();
+        if (!affected.insert(nt).second) continue;
+        for (const string& user : users[nt]) {
+            worklist.push_back(user);
+        }
+    }
+    for (const string& nt : affected) {
+        analysis.nullable.erase(nt);
+        analysis.FIRST.erase(nt);
+        if (analysis.nonTerminals.find(nt) != analysis.nonTerminals.end()) {
+            analysis.FIRST[nt];
+        }
+    }
+
+    FirstFixpoint(analysis, new_rules, &affected);
+
+    // FOLLOW: non-terminals in rules that changed or that read a changed
+    // FIRST set, in the rules they used to appear in, and everything their
+    // FOLLOW flows into
+    set<string> follow_affected;
+    worklist.clear();
+    auto seed_rule = [&](const Rule& rule) {
+        for (const string& symbol : rule.rhs) {
+            worklist.push_back(symbol);
+        }
+    };
+    for (const Rule& rule : old_rules) {
+        if (touched.find(rule.lhs) != touched.end()) seed_rule(rule);
+    }
+    for (const Rule& rule : new_rules) {
+        bool reads_changed = touched.find(rule.lhs) != touched.end();
+        for (size_t i = 0; i < rule.rhs.size() && !reads_changed; i++) {
+            reads_changed = affected.find(rule.rhs[i]) != affected.end();
+        }
+        if (reads_changed) seed_rule(rule);
+    }
+    worklist.insert(worklist.end(), touched.begin(), touched.end());
+    while (!worklist.empty()) {
+        string nt = worklist.back();
+        worklist.pop_back();
+        if (analysis.nonTerminals.find(nt) == analysis.nonTerminals.end() &&
+            analysis.FOLLOW.find(nt) == analysis.FOLLOW.end()) continue;
+        if (!follow_affected.insert(nt).second) continue;
+        for (const Rule* rule : rulesByLHS[nt]) {
+            seed_rule(*rule);
+        }
+    }
+    for (const string& nt : follow_affected) {
+        analysis.FOLLOW.erase(nt);
+        if (analysis.nonTerminals.find(nt) != analysis.nonTerminals.end()) {
+            analysis.FOLLOW[nt];
+        }
+    }
+    if (follow_affected.find(start) != follow_affected.end()) {
+        analysis.FOLLOW[start].insert("$");
+    }
+
+    FollowFixpoint(analysis, new_rules, &follow_affected);
+
+    set<string> recomputed = affected;
+    recomputed.insert(follow_affected.begin(), follow_affected.end());
+    return recomputed.size();
+}
+
+// Non-terminals with two alternatives that share a predict terminal
+size_t CountLL1Conflicts(const vector<Rule>& rules, const GrammarAnalysis& analysis) {
+    vector<set<string>> predict = PredictSets(rules, analysis);
+    unordered_map<string, set<string>> seen;
+    set<string> conflicting;
+    for (size_t r = 0; r < rules.size(); r++) {
+        set<string>& lhs_seen = seen[rules[r].lhs];
+        for (const string& terminal : predict[r]) {
+            if (!lhs_seen.insert(terminal).second) {
+                conflicting.insert(rules[r].lhs);
+            }
+        }
+    }
+    return conflicting.size();
+}
+
+// True if some non-terminal can derive a sentential form starting with itself
+// through first symbols, the left recursion Task 6 removes
+bool HasLeftRecursion(const vector<Rule>& rules) {
+    unordered_map<string, vector<string>> edges;
+    for (const Rule& rule : rules) {
+        if (!rule.rhs.empty()) {
+            edges[rule.lhs].push_back(rule.rhs[0]);
+        }
+    }
+
+    // Depth-first search for a cycle: 1 = on the stack, 2 = done
+    unordered_map<string, int> state;
+    for (const auto& entry : edges) {
+        if (state[entry.first] != 0) continue;
+        vector<pair<string, size_t>> stack;
+        stack.push_back({entry.first, 0});
+        state[entry.first] = 1;
+        while (!stack.empty()) {
+            const vector<string>& next = edges[stack.back().first];
+            if (stack.back().second == next.size()) {
+                state[stack.back().first] = 2;
+                stack.pop_back();
+                continue;
+            }
+            const string symbol = next[stack.back().second++];
+            if (state[symbol] == 1) return true;
+            if (state[symbol] == 0 && edges.find(symbol) != edges.end()) {
+                state[symbol] = 1;
+                stack.push_back({symbol, 0});
+            }
+        }
+    }
+    return false;
+}
+
+/*
+ * Task 11: make the grammar LL(1) automatically. Each iteration removes
+ * left recursion (when there is any), left factors, and checks for LL(1)
+ * conflicts, all on one in-memory grammar. Between stages the analysis is
+ * only recomputed for the non-terminals the stage touched. Stops when the
+ * grammar is conflict-free, stops changing, or after -i iterations.
+ * Prints the final grammar, then a timing line per stage.
+*/
+void Task11() {
+    struct StageTiming {
+        int iteration;
+        string stage;
+        double ms;
+        size_t touched;
+        size_t recomputed;
+    };
+    vector<StageTiming> timings;
+    auto elapsed_ms = [](chrono::steady_clock::time_point since) {
+        return chrono::duration<double, milli>(chrono::steady_clock::now() - since).count();
+    };
+
+    const string start = non_terminals[0];
+    vector<Rule> rules = grammar;
+
+    auto stage_start = chrono::steady_clock::now();
+    GrammarAnalysis analysis = AnalyzeGrammar(rules, start);
+    size_t conflicts = CountLL1Conflicts(rules, analysis);
+    timings.push_back({0, "analysis", elapsed_ms(stage_start), 0, analysis.nonTerminals.size()});
+
+    // Run one transformation and patch the analysis for what it touched
+    auto run_stage = [&](int iteration, const string& name, vector<Rule> (*transform)(const vector<Rule>&)) {
+        auto start_time = chrono::steady_clock::now();
+        vector<Rule> transformed = transform(rules);
+        set<string> touched = ChangedNonTerminals(rules, transformed);
+        size_t recomputed = UpdateAnalysis(analysis, rules, transformed, touched, start);
+        rules.swap(transformed);
+        timings.push_back({iteration, name, elapsed_ms(start_time), touched.size(), recomputed});
+        return !touched.empty();
+    };
+
+    // Left recursion the Task 6 algorithm leaves behind (through cycles or
+    // nullable symbols) only grows the grammar when retried, so stop trying
+    bool remove_left_recursion = true;
+    for (int iteration = 1; iteration <= max_iterations && conflicts > 0; iteration++) {
+        bool changed = false;
+        if (remove_left_recursion && HasLeftRecursion(rules)) {
+            changed = run_stage(iteration, "left recursion", EliminateLeftRecursion) || changed;
+            remove_left_recursion = !HasLeftRecursion(rules);
+        }
+        changed = run_stage(iteration, "left factoring", LeftFactor) || changed;
+
+        stage_start = chrono::steady_clock::now();
+        conflicts = CountLL1Conflicts(rules, analysis);
+        timings.push_back({iteration, "conflict check", elapsed_ms(stage_start), 0, 0});
+
+        if (!changed) {
+            break;
+        }
+    }
+
+    sort(rules.begin(), rules.end(), compareLexicographically);
+    PrintRules(rules);
+
+    cout << "Conflicts = " << conflicts << endl;
+    for (const StageTiming& timing : timings) {
+        cout << "iteration " << timing.iteration << ", " << timing.stage << ": "
+             << timing.ms << " ms, touched " << timing.touched
+             << ", recomputed " << timing.recomputed << endl;
+    }
+}
+    
+// Parse a whole argument as a positive int
+bool ParsePositive(const char* text, int& value) {
+    char* end;
+    long parsed = strtol(text, &end, 10);
+    if (end == text || *end != '\0' || parsed <= 0 || parsed > 1000000) {
+        return false;
+    }
+    value = (int) parsed;
+    return true;
 }
     
 int main (int argc, char* argv[])
@@ -765,10 +2862,67 @@ int main (int argc, char* argv[])
      */
 
     task = atoi(argv[1]);
+
+    // Optional flags after the task number
+    for (int i = 2; i < argc; i++) {
+        string option = argv[i];
+        if (option == "-r") {
+            reduce_grammar = true;
+        } else if (option == "-k") {
+            if (i + 1 >= argc || !ParsePositive(argv[i + 1], lookahead_k)) {
+                cout << "Error: invalid value for -k, expected a positive integer\n";
+                return 1;
+            }
+            i++;
+        } else if (option == "-t") {
+            transform_grammar = true;
+        } else if (option == "-b") {
+            emit_benchmark = true;
+        } else if (option == "-s") {
+            streaming_input = true;
+        } else if (option == "-i") {
+            if (i + 1 >= argc || !ParsePositive(argv[i + 1], max_iterations)) {
+                cout << "Error: invalid value for -i, expected a positive integer\n";
+                return 1;
+            }
+            i++;
+        } else {
+            cout << "Error: unrecognized option " << option << "\n";
+            return 1;
+        }
+    }
     
-    ReadGrammar();  // Reads the input grammar from standard input
-                    // and represent it internally in data structures
-                    // ad described in project 2 presentation file
+    if (streaming_input) {
+        ReadGrammarStreaming();
+
+        // Tasks 1-4 run on the compact grammar, without expanding it
+        if (task == 1 || (task >= 2 && task <= 4 && !reduce_grammar)) {
+            switch (task) {
+                case 1: CompactTask1();
+                    break;
+
+                case 2: CompactTask2();
+                    break;
+
+                case 3: CompactTask3();
+                    break;
+
+                case 4: CompactTask4();
+                    break;
+            }
+            return 0;
+        }
+        MaterializeGrammar();
+    } else {
+        ReadGrammar();  // Reads the input grammar from standard input
+                        // and represent it internally in data structures
+                        // ad described in project 2 presentation file
+    }
+
+    // Shrink the grammar before any analysis when asked to
+    if (reduce_grammar && ((task >= 2 && task <= 6) || task >= 8)) {
+        RemoveUselessSymbols();
+    }
 
     switch (task) {
         case 1: Task1();
@@ -789,6 +2943,21 @@ int main (int argc, char* argv[])
         case 6: Task6();
             break;
 
+        case 7: Task7();
+            break;
+
+        case 8: Task8();
+            break;
+
+        case 9: Task9();
+            break;
+
+        case 10: Task10();
+            break;
+
+        case 11: Task11();
+            break;
+
         default:
             cout << "Error: unrecognized task number " << task << "\n";
             break;